@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+#include "Benchmark.h"
+#include "ComputerPlayer.h"
+#include "Perft.h"
+
+namespace ConnectFour
+{
+  // all workloads start from the same seed so every run does the same work
+  static const unsigned int BenchmarkSeed = 1;
+
+  // a timed run repeats its workload until at least this long has passed.
+  // one pass of a workload only takes tens of milliseconds, short enough
+  // for a single scheduler hiccup to move a run's rate by several percent
+  static const double MinRunSeconds = 0.5;
+
+  // board primitives: random moves, each one made, taken back and made again
+  static uint64_t BenchmarkMoves(const Board& Prototype)
+  {
+    Board b = Prototype;
+    std::mt19937 Random(BenchmarkSeed);
+    std::uniform_int_distribution<unsigned int> ColumnDistribution(0, b.GetWidth() - 1);
+    uint64_t Operations = 0;
+
+    for (unsigned int Game = 0; Game < 20000; Game++)
+    {
+      b.Reset();
+      auto Status = Board::GameStatus::Ongoing;
+      while (Status == Board::GameStatus::Ongoing)
+      {
+        unsigned int Column = ColumnDistribution(Random);
+        while (!b.CanMakeMove(Column))
+        {
+          Column = (Column + 1) % b.GetWidth();
+        }
+
+        auto Mover = SideToMove(b);
+        b.MakeMove(Mover, Column);
+        b.UndoMove(Column);
+        Status = b.MakeMove(Mover, Column);
+        Operations += 3;
+      }
+    }
+
+    return Operations;
+  }
+
+  // the computer player's decision on positions from random play
+  static uint64_t BenchmarkComputerMoves(const Board& Prototype)
+  {
+    Board b = Prototype;
+    std::mt19937 Random(BenchmarkSeed);
+    uint64_t Decisions = 0;
+
+    std::uniform_int_distribution<unsigned int> ColumnDistribution(0, b.GetWidth() - 1);
+
+    for (unsigned int Game = 0; Game < 5000; Game++)
+    {
+      // ask for a move at every position of a randomly played game
+      b.Reset();
+      auto Status = Board::GameStatus::Ongoing;
+      while (Status == Board::GameStatus::Ongoing)
+      {
+        ChooseComputerMove(b, SideToMove(b), Random);
+        ++Decisions;
+
+        unsigned int Column = ColumnDistribution(Random);
+        while (!b.CanMakeMove(Column))
+        {
+          Column = (Column + 1) % b.GetWidth();
+        }
+        Status = b.MakeMove(SideToMove(b), Column);
+      }
+    }
+
+    return Decisions;
+  }
+
+  // whole games of the computer player against itself
+  static uint64_t BenchmarkSelfPlay(const Board& Prototype)
+  {
+    Board b = Prototype;
+    std::mt19937 Random(BenchmarkSeed);
+    uint64_t Games = 0;
+
+    for (; Games < 5000; Games++)
+    {
+      b.Reset();
+      auto Status = Board::GameStatus::Ongoing;
+      while (Status == Board::GameStatus::Ongoing)
+      {
+        auto Mover = SideToMove(b);
+        Status = b.MakeMove(Mover, ChooseComputerMove(b, Mover, Random));
+      }
+    }
+
+    return Games;
+  }
+
+  // every move sequence of a fixed length on one thread without the hash, so
+  // it times only the board's make, undo, win check and legal-move mask
+  static uint64_t BenchmarkPerft(const Board& Prototype)
+  {
+    return Perft(Prototype, 7, 1, 0).Nodes;
+  }
+
+  /// <summary>
+  /// the median of the rates and a distribution-free 95% confidence interval
+  /// for it, taken from the order statistics of a binomial(n, 1/2)
+  /// </summary>
+  static BenchmarkResult Summarize(std::string Name, std::string Unit, std::vector<double> Rates)
+  {
+    std::sort(Rates.begin(), Rates.end());
+    size_t n = Rates.size();
+
+    double Median = (n % 2 == 1) ? Rates[n / 2] : (Rates[n / 2 - 1] + Rates[n / 2]) / 2;
+
+    // find the largest k with P(X < k) <= 2.5%; the interval is the k-th
+    // smallest to the k-th largest rate.  with only a few runs this is the
+    // full range.
+    size_t k = 0;
+    double Cumulative = 0;
+    double Choose = 1;   // n choose i
+    for (size_t i = 0; i < n / 2; i++)
+    {
+      Cumulative += Choose * std::pow(0.5, (double)n);
+      if (Cumulative > 0.025)
+        break;
+      k = i + 1;
+      Choose = Choose * (double)(n - i) / (double)(i + 1);
+    }
+    size_t LowIndex = (k > 0) ? k - 1 : 0;
+
+    return { std::move(Name), std::move(Unit), Median, Rates[LowIndex], Rates[n - 1 - LowIndex] };
+  }
+
+  std::vector<BenchmarkResult> RunBenchmarks(const Board& Prototype, unsigned int Runs)
+  {
+    struct Benchmark
+    {
+      const char* Name;
+      const char* Unit;
+      std::function<uint64_t(const Board&)> Run;
+    };
+
+    const Benchmark Benchmarks[] =
+    {
+      { "board_moves", "ops/sec", BenchmarkMoves },
+      { "computer_moves", "decisions/sec", BenchmarkComputerMoves },
+      { "self_play", "games/sec", BenchmarkSelfPlay },
+      { "board_perft", "nodes/sec", BenchmarkPerft },
+    };
+
+    // one untimed run of each warms the caches and the allocator
+    for (auto& Bench : Benchmarks)
+    {
+      Bench.Run(Prototype);
+    }
+
+    // the benchmarks take turns, one run each per round, so a slow spell on
+    // the machine is spread across all of them and shows in their intervals
+    // rather than landing on whichever one happened to be running
+    std::vector<std::vector<double>> Rates(std::size(Benchmarks));
+    for (unsigned int i = 0; i < Runs; i++)
+    {
+      for (size_t j = 0; j < std::size(Benchmarks); j++)
+      {
+        auto StartTime = std::chrono::steady_clock::now();
+        uint64_t Count = 0;
+        double Seconds = 0;
+        while (Seconds < MinRunSeconds)
+        {
+          Count += Benchmarks[j].Run(Prototype);
+          Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+        }
+        Rates[j].push_back(Count / Seconds);
+      }
+    }
+
+    std::vector<BenchmarkResult> Results;
+    for (size_t j = 0; j < std::size(Benchmarks); j++)
+    {
+      Results.push_back(Summarize(Benchmarks[j].Name, Benchmarks[j].Unit, std::move(Rates[j])));
+    }
+
+    return Results;
+  }
+
+  bool SaveBaseline(const std::string& Path, const Board& Variant, const std::vector<BenchmarkResult>& Results)
+  {
+    std::ofstream Out(Path, std::ios::trunc);
+    Out << "variant " << Variant.GetWidth() << ' ' << Variant.GetHeight() << ' ' << Variant.GetConnectLength() << '\n';
+    for (auto& Result : Results)
+    {
+      Out << Result.Name << ' ' << Result.Unit << ' ' << Result.Median << ' ' << Result.Low << ' ' << Result.High << '\n';
+    }
+    return (bool)Out;
+  }
+
+  std::optional<BenchmarkBaseline> LoadBaseline(const std::string& Path)
+  {
+    std::ifstream In(Path);
+    std::string Line;
+    if (!std::getline(In, Line))
+      return std::nullopt;
+
+    // results mean nothing without the variant they were measured on
+    BenchmarkBaseline Baseline;
+    std::istringstream Header(Line);
+    std::string Tag;
+    if (!(Header >> Tag >> Baseline.Width >> Baseline.Height >> Baseline.ConnectLength) || Tag != "variant")
+      return std::nullopt;
+
+    while (std::getline(In, Line))
+    {
+      std::istringstream Fields(Line);
+      BenchmarkResult Result;
+      if (Fields >> Result.Name >> Result.Unit >> Result.Median >> Result.Low >> Result.High)
+        Baseline.Results.push_back(Result);
+    }
+
+    return Baseline;
+  }
+
+  unsigned int ReportBenchmarks(const std::vector<BenchmarkResult>& Results,
+    const std::vector<BenchmarkResult>* Baseline, double Threshold)
+  {
+    unsigned int Regressions = 0;
+
+    for (auto& Result : Results)
+    {
+      std::cout << Result.Name << ": " << Result.Median << " " << Result.Unit
+        << " (95% CI " << Result.Low << " - " << Result.High << ")";
+
+      const BenchmarkResult* Saved = nullptr;
+      if (Baseline != nullptr)
+      {
+        for (auto& r : *Baseline)
+        {
+          if (r.Name == Result.Name)
+            Saved = &r;
+        }
+      }
+
+      if (Saved != nullptr && Saved->Median > 0)
+      {
+        double Change = (Result.Median - Saved->Median) / Saved->Median;
+        std::cout << ", " << (Change >= 0 ? "+" : "") << Change * 100 << "% vs baseline";
+
+        if (Change < -Threshold && Result.High < Saved->Low)
+        {
+          std::cout << "  REGRESSION";
+          ++Regressions;
+        }
+      }
+
+      std::cout << "\n";
+    }
+
+    return Regressions;
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+
+namespace ConnectFour
+{
+  /// <summary>
+  /// the measured rate of one benchmark over several runs
+  /// </summary>
+  struct BenchmarkResult
+  {
+    std::string Name;
+    std::string Unit;   // what the rates count, e.g. "moves/sec"
+    double Median;
+    double Low;         // 95% confidence interval of the median
+    double High;
+  };
+
+  /// <summary>
+  /// saved results and the variant they were measured on
+  /// </summary>
+  struct BenchmarkBaseline
+  {
+    unsigned int Width;
+    unsigned int Height;
+    unsigned int ConnectLength;
+    std::vector<BenchmarkResult> Results;
+  };
+
+  /// <summary>
+  /// runs each benchmark the given number of times on the given variant.  the
+  /// workloads are seeded the same way on every run, so runs and builds are
+  /// timed on identical games, and each run lasts at least half a second.
+  /// with four benchmarks, a nine-run bench takes about 20 seconds.
+  /// </summary>
+  /// <param name="Prototype">an empty board of the variant to measure</param>
+  /// <param name="Runs">number of timed runs of each benchmark</param>
+  /// <returns>one result per benchmark</returns>
+  std::vector<BenchmarkResult> RunBenchmarks(const Board& Prototype, unsigned int Runs);
+
+  /// <summary>
+  /// writes results as a baseline: a "variant width height connect" line for
+  /// the board they were measured on, then one "name unit median low high"
+  /// line each
+  /// </summary>
+  /// <returns>true if the file was written, false otherwise</returns>
+  bool SaveBaseline(const std::string& Path, const Board& Variant, const std::vector<BenchmarkResult>& Results);
+
+  /// <summary>
+  /// reads a baseline written by SaveBaseline
+  /// </summary>
+  /// <returns>the baseline, or nullopt if the file can't be read or has no variant line</returns>
+  std::optional<BenchmarkBaseline> LoadBaseline(const std::string& Path);
+
+  /// <summary>
+  /// prints the results, and against a baseline, the change for each
+  /// benchmark.  a benchmark has regressed when its median is more than
+  /// Threshold below the baseline's and the two confidence intervals don't
+  /// overlap, so run-to-run noise alone doesn't flag it.
+  /// </summary>
+  /// <param name="Results">the current results</param>
+  /// <param name="Baseline">the saved results to compare with, if any</param>
+  /// <param name="Threshold">the fraction a median may drop before it counts</param>
+  /// <returns>the number of regressions found</returns>
+  unsigned int ReportBenchmarks(const std::vector<BenchmarkResult>& Results,
+    const std::vector<BenchmarkResult>* Baseline, double Threshold);
+}
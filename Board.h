@@ -0,0 +1,416 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <exception>
+#include <cstdint>
+#include <cstdio>
+
+// ANSI escape codes for text color
+#define ANSI_COLOR_RED      "\x1b[31m"
+#define ANSI_COLOR_RESET    "\x1b[0m"
+#define ANSI_HIGHLIGHT      "\033[7m"
+#define ANSI_UNDO_HIGHLIGHT "\033[0m"
+
+namespace ConnectFour
+{
+  class Board
+  {
+  public:
+    enum class SpaceState : uint8_t
+    {
+      Empty,
+      Player1,
+      Player2,
+    };
+
+    enum class MoveType
+    {
+      Player1,
+      Player2,
+    };
+
+    // the state of the game after a move
+    enum class GameStatus
+    {
+      Ongoing,
+      Win,      // the player who just moved has won
+      Draw,
+    };
+
+    /// <summary>
+    /// this data structure holds the most recent move
+    /// </summary>
+    struct LastMove_t
+    {
+      unsigned int x;
+      unsigned int y;
+      bool isInitialized;   // indicates whether this has been set at least once
+    } LastMove;
+
+    // the standard board; other sizes can be chosen when the board is built
+    static const unsigned int DefaultWidth = 7;
+    static const unsigned int DefaultHeight = 6;
+
+    static const unsigned int DefaultConnectLength = 4;
+
+    // move strings name each column with one digit
+    static const unsigned int MinConnectLength = 3;
+    static const unsigned int MaxWidth = 9;
+    static const unsigned int MaxHeight = 16;
+
+    /// <summary>
+    /// constructor
+    /// </summary>
+    /// <param name="BoardWidth">number of columns</param>
+    /// <param name="BoardHeight">number of rows</param>
+    /// <param name="Connect">number of tokens in a row needed to win</param>
+    explicit Board(unsigned int BoardWidth = DefaultWidth, unsigned int BoardHeight = DefaultHeight,
+      unsigned int Connect = DefaultConnectLength) :
+      LastMove{ 0, 0, false },
+      Width(BoardWidth),
+      Height(BoardHeight),
+      ConnectLength(Connect),
+      LegalMask(0)
+    {
+      if (ConnectLength < MinConnectLength)
+        throw std::exception{ "Unsupported connect length" };
+      // a line has to fit both across and up the board
+      if (Width < ConnectLength || Width > MaxWidth || Height < ConnectLength || Height > MaxHeight)
+        throw std::exception{ "Unsupported board size" };
+
+      // only allocate once the size is known to be sensible
+      board.assign(Width * Height, SpaceState::Empty);
+      LegalMask = (1u << Width) - 1;
+    }
+
+    /// <summary>
+    /// empty the board for a new game, reusing its storage
+    /// </summary>
+    void Reset()
+    {
+      std::fill(board.begin(), board.end(), SpaceState::Empty);
+      ColumnCounts.fill(0);
+      MoveCount = 0;
+      LegalMask = (1u << Width) - 1;
+      LastMove = { 0, 0, false };
+    }
+
+    unsigned int GetWidth() const
+    {
+      return Width;
+    }
+
+    unsigned int GetHeight() const
+    {
+      return Height;
+    }
+
+    unsigned int GetConnectLength() const
+    {
+      return ConnectLength;
+    }
+
+    /// <summary>
+    /// this function returns an enum indicating the state of the given position
+    /// on the board
+    /// </summary>
+    /// <param name="Row">0-based index of the row</param>
+    /// <param name="Column">0-based index of the column</param>
+    /// <returns>an enum indicating the state of that position</returns>
+    SpaceState GetSpace(unsigned int Row, unsigned int Column) const
+    {
+      if (Row >= Height)
+        throw std::exception{ "Row out of range" };
+      if (Column >= Width)
+        throw std::exception{ "Column out of range" };
+
+      return Cell(Row, Column);
+    }
+
+    /// <summary>
+    /// this function returns the row that the next token dropped into this
+    /// column would land in.  row 0 is the top of the board.
+    /// </summary>
+    /// <param name="Column">0-based index of the column</param>
+    /// <returns>0-based index of the lowest empty row, or Height if the column is full</returns>
+    unsigned int GetColumnHeight(unsigned int Column) const
+    {
+      if (Column >= Width)
+        throw std::exception{ "Column out of range" };
+
+      if (ColumnCounts[Column] == Height)
+        return Height; // Column is full
+      return Height - 1 - ColumnCounts[Column];
+    }
+
+    /// <summary>
+    /// check to see if it's possible to make a move to place a token in the given column
+    /// </summary>
+    /// <param name="Column">0-based index of the column</param>
+    /// <returns>true if the move is possible, false otherwise</returns>
+    bool CanMakeMove(unsigned int Column) const
+    {
+      if (Column >= Width)
+        throw std::exception{ "Column out of range" };
+
+      return (LegalMask & (1u << Column)) != 0;
+    }
+
+    /// <summary>
+    /// the columns that can still be played, as a bit mask with bit N set for column N
+    /// </summary>
+    unsigned int LegalMoves() const
+    {
+      return LegalMask;
+    }
+
+    unsigned int GetMoveCount() const
+    {
+      return MoveCount;
+    }
+
+    bool IsFull() const
+    {
+      return MoveCount == Width * Height;
+    }
+
+    /// <summary>
+    /// if possible, put a token in the given column and adjust the board state accordingly
+    /// </summary>
+    /// <param name="Move"></param>
+    /// <param name="Column"></param>
+    /// <returns>whether the move won the game, filled the board, or neither</returns>
+    GameStatus MakeMove(MoveType Move, unsigned int Column)
+    {
+      if (!CanMakeMove(Column))
+        throw std::exception{ "Cannot make move" };
+
+      auto CurrentHeight = GetColumnHeight(Column);
+      SetSpace(CurrentHeight, Column, ConvertMoveToSpaceState(Move));
+
+      if (++ColumnCounts[Column] == Height)
+        LegalMask &= ~(1u << Column);
+      ++MoveCount;
+
+      // only lines through the new token can have been completed by this move
+      if (IsWinningMove(CurrentHeight, Column))
+        return GameStatus::Win;
+      if (IsFull())
+        return GameStatus::Draw;
+      return GameStatus::Ongoing;
+    }
+
+    /// <summary>
+    /// take back the top token in the given column, so a move can be tried and
+    /// undone without copying the board
+    /// </summary>
+    /// <param name="Column">0-based index of the column</param>
+    void UndoMove(unsigned int Column)
+    {
+      if (Column >= Width)
+        throw std::exception{ "Column out of range" };
+      if (ColumnCounts[Column] == 0)
+        throw std::exception{ "Cannot undo move" };
+
+      // the top token is the last one counted into the column
+      Cell(Height - ColumnCounts[Column], Column) = SpaceState::Empty;
+      --ColumnCounts[Column];
+      --MoveCount;
+      LegalMask |= 1u << Column;
+
+      // the move before this one isn't tracked
+      LastMove.isInitialized = false;
+    }
+
+    // output the board to the screen
+    void PrintBoard() const
+    {
+      auto GetSpaceStateCharacter = [](SpaceState s)
+      {
+        switch (s)
+        {
+        case SpaceState::Empty:
+        default:
+          return ". "; // Changed to '.' for better visibility
+        case SpaceState::Player1:
+          // this creates a string like "<set red>" "x " "<reset color>"
+          return ANSI_COLOR_RED "X " ANSI_COLOR_RESET;
+        case SpaceState::Player2:
+          return "O ";
+        }
+      };
+
+      // let's clear the screen
+      printf("\033[2J"); // Clear the entire screen
+      printf("\033[H"); // Reset cursor position to the top-left
+      fflush(stdout);  // Important: Flush the output buffer
+
+      for (unsigned int i = 0; i < Height ; i++) // Iterate from bottom to top
+      {
+        for (unsigned int j = 0; j < Width; j++)
+        {
+          // set the highlight if this location is the most recent move
+          if (IsLastMove(i, j))
+          {
+            std::cout << ANSI_HIGHLIGHT;
+          }
+          std::cout << GetSpaceStateCharacter(GetSpace(i, j));
+          if (IsLastMove(i, j))
+          {
+            std::cout << ANSI_UNDO_HIGHLIGHT;
+          }
+        }
+        std::cout << std::endl << std::endl;
+      }
+
+      for (unsigned int i = 0; i < Width; i++)
+      {
+        std::cout << i + 1 << " ";
+      }
+
+      std::cout << "\n";
+
+      // make a flowerbox to help separate boards
+      for (unsigned int i = 0; i < Width; i++)
+      {
+        std::cout << "**";
+      }
+
+      std::cout << "\n";
+      
+    }
+
+    /// <summary>
+    /// check to see if there is a winning state
+    /// </summary>
+    /// <param name="player">a SpaceState enum indicating player</param>
+    /// <returns>true if this is a winning condition, false otherwise</returns>
+    bool CheckWin(SpaceState player) const {
+      // try every position as the start of a line in each direction
+      for (int r = 0; r < (int)Height; r++) {
+        for (int c = 0; c < (int)Width; c++) {
+          if (Cell(r, c) != player) {
+            continue;
+          }
+
+          for (auto& Direction : Directions) {
+            int LastRow = r + (int)(ConnectLength - 1) * Direction[0];
+            int LastColumn = c + (int)(ConnectLength - 1) * Direction[1];
+            if (LastRow < 0 || LastRow >= (int)Height || LastColumn < 0 || LastColumn >= (int)Width) {
+              continue;
+            }
+
+            unsigned int i = 1;
+            while (i < ConnectLength && Cell(r + i * Direction[0], c + i * Direction[1]) == player) {
+              i++;
+            }
+            if (i == ConnectLength) {
+              return true;
+            }
+          }
+        }
+      }
+
+      return false;
+    }
+
+    static SpaceState ConvertMoveToSpaceState(MoveType Move)
+    {
+      if (Move == MoveType::Player1)
+        return SpaceState::Player1;
+      else
+        return SpaceState::Player2;
+    }
+
+  private:
+    // put a token in this place on the board
+    void SetSpace(unsigned int Row, unsigned int Column, SpaceState NewState)
+    {
+      if (Row >= Height)
+        throw std::exception{ "Row out of range" };
+      if (Column >= Width)
+        throw std::exception{ "Column out of range" };
+
+      LastMove.x = Column;
+      LastMove.y = Row;
+      LastMove.isInitialized = true;
+
+      Cell(Row, Column) = NewState;
+    }
+
+    /// <summary>
+    /// check whether the token at the given position is part of a winning line.
+    /// this only walks the lines through that one position, so unlike CheckWin
+    /// its cost doesn't grow with the size of the board.
+    /// </summary>
+    /// <param name="Row">0-based index of the row</param>
+    /// <param name="Column">0-based index of the column</param>
+    /// <returns>true if the token there completes a line, false otherwise</returns>
+    bool IsWinningMove(unsigned int Row, unsigned int Column) const
+    {
+      const SpaceState player = Cell(Row, Column);
+
+      for (auto& Direction : Directions)
+      {
+        // count matching tokens on both sides of this one
+        unsigned int Run = 1;
+        for (int Sign = -1; Sign <= 1; Sign += 2)
+        {
+          int r = (int)Row + Sign * Direction[0];
+          int c = (int)Column + Sign * Direction[1];
+          while (r >= 0 && r < (int)Height && c >= 0 && c < (int)Width && Cell(r, c) == player)
+          {
+            ++Run;
+            r += Sign * Direction[0];
+            c += Sign * Direction[1];
+          }
+        }
+
+        if (Run >= ConnectLength)
+          return true;
+      }
+
+      return false;
+    }
+
+    // the storage for a position; the whole board is one contiguous block so
+    // copying a board is a single allocation
+    SpaceState& Cell(unsigned int Row, unsigned int Column)
+    {
+      return board[Row * Width + Column];
+    }
+
+    const SpaceState& Cell(unsigned int Row, unsigned int Column) const
+    {
+      return board[Row * Width + Column];
+    }
+
+    /// <summary>
+    /// this checks to see if the given row and column for the board
+    /// are the coordinates of the last move played
+    /// </summary>
+    /// <param name="Row"></param>
+    /// <param name="Column"></param>
+    /// <returns></returns>
+    bool IsLastMove(unsigned int Row, unsigned int Column) const
+    {
+      return (LastMove.isInitialized && LastMove.x == Column &&
+        LastMove.y == Row);
+    }
+    
+
+    // row and column steps along a line: horizontal, vertical and the two diagonals
+    static constexpr int Directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+    unsigned int Width;
+    unsigned int Height;
+    unsigned int ConnectLength;
+    std::vector<SpaceState> board;   // row-major, row 0 at the top
+    std::array<unsigned int, MaxWidth> ColumnCounts{};   // tokens in each column; only Width are used
+    unsigned int MoveCount = 0;
+    unsigned int LegalMask;                              // bit N set while column N isn't full
+  };
+}
@@ -0,0 +1,113 @@
+#include "ComputerPlayer.h"
+
+namespace ConnectFour
+{
+  unsigned int ChooseComputerMove(const Board& b, Board::MoveType Player, std::mt19937& Random)
+  {
+    auto Opponent = (Player == Board::MoveType::Player1) ?
+      Board::MoveType::Player2 : Board::MoveType::Player1;
+
+    int autoMove = 1 + std::uniform_int_distribution<int>(0, b.GetWidth() - 1)(Random);
+
+    // the random move: skip columns till one is available.  since it's not a
+    // draw, there must be an available column
+    auto RandomMove = [&]()
+    {
+      while (!b.CanMakeMove(autoMove - 1))
+      {
+        autoMove++;
+        if (autoMove > b.GetWidth())
+        {
+          autoMove = 1;   // autoMove is 1-indexed
+        }
+      }
+
+      return (unsigned int)(autoMove - 1);
+    };
+
+    // iterate through the possible board plays, looking for either a winning play,
+    // or a blocking play, or a random play if neither of those are available.  To
+    // make the game more difficult, this could look to see if a move isn't likely
+    // to cause a win..
+
+    // early in the game neither side has enough tokens down to connect with
+    // its next one.  sides alternate, so neither has more than half the moves
+    // rounded up, and the probes below can't find anything until one of them
+    // could have ConnectLength - 1.  skip straight to the random move, which
+    // is the same move the probes would have fallen through to
+    if ((b.GetMoveCount() + 1) / 2 < b.GetConnectLength() - 1)
+    {
+      return RandomMove();
+    }
+
+    // try each move on one scratch copy of the board and take it back again,
+    // rather than copying the whole board for every column probed
+    Board Scratch = b;
+
+    // look for winning play
+    for (int i = 0; i < b.GetWidth(); i++)
+    {
+      // make a move, if possible, and then check for a win
+      if (Scratch.CanMakeMove(i))
+      {
+        bool bWins = Scratch.MakeMove(Player, i) == Board::GameStatus::Win;
+        Scratch.UndoMove(i);
+
+        if (bWins)
+        {
+          return i;
+        }
+      }
+    } // end for loop
+
+    // look for a blocking play
+    for (int i = 0; i < b.GetWidth(); i++)
+    {
+      // make a move, if possible, and then check for a win by the opponent
+      if (Scratch.CanMakeMove(i))
+      {
+        bool bWins = Scratch.MakeMove(Opponent, i) == Board::GameStatus::Win;
+        Scratch.UndoMove(i);
+
+        if (bWins)
+        {
+          // let's block the opponent
+          return i;
+        }
+      }
+    } // end for loop
+
+    // a blocking move was not found, so make a random move
+    return RandomMove();
+  }
+
+  std::optional<std::vector<unsigned int>> ParseMoves(std::string_view Moves, unsigned int Width)
+  {
+    std::vector<unsigned int> Columns;
+    Columns.reserve(Moves.size());
+
+    for (char c : Moves)
+    {
+      if (c < '1' || c > '0' + (int)Width)
+        return std::nullopt;
+      Columns.push_back(c - '1');
+    }
+
+    return Columns;
+  }
+
+  std::optional<Board::GameStatus> PlayMoves(Board& b, const std::vector<unsigned int>& Columns)
+  {
+    auto Status = Board::GameStatus::Ongoing;
+
+    for (auto Column : Columns)
+    {
+      if (Status != Board::GameStatus::Ongoing || !b.CanMakeMove(Column))
+        return std::nullopt;
+
+      Status = b.MakeMove(SideToMove(b), Column);
+    }
+
+    return Status;
+  }
+}
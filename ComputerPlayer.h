@@ -0,0 +1,47 @@
+#pragma once
+
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "Board.h"
+
+namespace ConnectFour
+{
+  /// <summary>
+  /// picks the column for the computer player: a winning move if there is one,
+  /// otherwise a move that blocks the opponent's win, otherwise a random column
+  /// </summary>
+  /// <param name="b">the current board; it's not the computer's to modify</param>
+  /// <param name="Player">the side the computer is moving for</param>
+  /// <param name="Random">the source for the random fallback move</param>
+  /// <returns>0-based index of the column to play</returns>
+  unsigned int ChooseComputerMove(const Board& b, Board::MoveType Player, std::mt19937& Random);
+
+  /// <summary>
+  /// the player whose turn it is, assuming Player1 moved first
+  /// </summary>
+  inline Board::MoveType SideToMove(const Board& b)
+  {
+    return (b.GetMoveCount() % 2 == 0) ? Board::MoveType::Player1 : Board::MoveType::Player2;
+  }
+
+  /// <summary>
+  /// parses a move string such as "44536", one 1-based column per character
+  /// </summary>
+  /// <param name="Moves">the move string</param>
+  /// <param name="Width">number of columns on the board; at most 9 can be named</param>
+  /// <returns>the 0-based columns, or nullopt if a character isn't a column</returns>
+  std::optional<std::vector<unsigned int>> ParseMoves(std::string_view Moves, unsigned int Width);
+
+  /// <summary>
+  /// plays a sequence of moves onto the board, alternating players and starting
+  /// with whoever is next to move
+  /// </summary>
+  /// <param name="b">the board to play onto</param>
+  /// <param name="Columns">0-based columns to play</param>
+  /// <returns>the status after the last move, or nullopt if a move was illegal
+  /// or came after the game had ended</returns>
+  std::optional<Board::GameStatus> PlayMoves(Board& b, const std::vector<unsigned int>& Columns);
+}
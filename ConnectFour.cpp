@@ -3,14 +3,28 @@
 #include <limits>
 #include <vector>
 #include <random>
-
-
-
-// ANSI escape codes for text color
-#define ANSI_COLOR_RED      "\x1b[31m"
-#define ANSI_COLOR_RESET    "\x1b[0m"
-#define ANSI_HIGHLIGHT      "\033[7m"
-#define ANSI_UNDO_HIGHLIGHT "\033[0m"
+#include <string>
+#include <fstream>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX            // keep windows.h from clobbering std::numeric_limits<>::max
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+#include "Board.h"
+#include "ComputerPlayer.h"
+#include "Benchmark.h"
+#include "Perft.h"
 
 namespace ConnectFour
 {
@@ -23,298 +37,1073 @@ namespace ConnectFour
     GameOverException(const char* const Message) : std::exception(Message) {}
   };
 
-  class Board
+  /// <summary>
+  /// counters for finished games and moves, plus a histogram of how long the
+  /// computer player takes to move.  these are written in the prometheus text
+  /// exposition format.  everything runs on the game thread, so plain counters
+  /// are enough.
+  /// </summary>
+  class Metrics
   {
   public:
-    enum class SpaceState
-    {
-      Empty,
-      Player1,
-      Player2,
-    };
-
-    enum class MoveType
+    void RecordMove(Board::MoveType Move)
     {
-      Player1,
-      Player2,
-    };
+      ++Moves[(size_t)Move];
+    }
 
     /// <summary>
-    /// this data structure holds the most recent move
+    /// count a finished game
     /// </summary>
-    struct LastMove_t
+    /// <param name="Winner">the winning player, or Empty for a draw</param>
+    void RecordGame(Board::SpaceState Winner)
     {
-      unsigned int x;
-      unsigned int y;
-      bool isInitialized;   // indicates whether this has been set at least once
-    } LastMove;
+      ++Games[(size_t)Winner];
+    }
 
-    static const unsigned int Width = 7;
-    static const unsigned int Height = 6;
+    void RecordComputerLatency(std::chrono::nanoseconds Elapsed)
+    {
+      double Seconds = std::chrono::duration<double>(Elapsed).count();
 
-    Board() : LastMove{ 0, 0, false }, board(Height, std::vector<SpaceState>(Width, SpaceState::Empty))
+      // prometheus buckets are cumulative
+      for (size_t i = 0; i < LatencyBuckets.size(); i++)
+      {
+        if (Seconds <= LatencyBuckets[i])
+          ++LatencyCounts[i];
+      }
+      ++LatencyCount;
+      LatencySum += Seconds;
+    }
+
+    void Write(std::ostream& Out) const
     {
-      
+      Out << "# HELP connectfour_games_total Finished games, by result.\n";
+      Out << "# TYPE connectfour_games_total counter\n";
+      Out << "connectfour_games_total{result=\"draw\"} " << Games[(size_t)Board::SpaceState::Empty] << "\n";
+      Out << "connectfour_games_total{result=\"player1\"} " << Games[(size_t)Board::SpaceState::Player1] << "\n";
+      Out << "connectfour_games_total{result=\"player2\"} " << Games[(size_t)Board::SpaceState::Player2] << "\n";
+
+      Out << "# HELP connectfour_moves_total Moves played, by player.\n";
+      Out << "# TYPE connectfour_moves_total counter\n";
+      Out << "connectfour_moves_total{player=\"player1\"} " << Moves[(size_t)Board::MoveType::Player1] << "\n";
+      Out << "connectfour_moves_total{player=\"player2\"} " << Moves[(size_t)Board::MoveType::Player2] << "\n";
+
+      Out << "# HELP connectfour_computer_move_seconds Time taken by the computer player to choose and make a move.\n";
+      Out << "# TYPE connectfour_computer_move_seconds histogram\n";
+      for (size_t i = 0; i < LatencyBuckets.size(); i++)
+      {
+        Out << "connectfour_computer_move_seconds_bucket{le=\"" << LatencyBuckets[i] << "\"} " << LatencyCounts[i] << "\n";
+      }
+      Out << "connectfour_computer_move_seconds_bucket{le=\"+Inf\"} " << LatencyCount << "\n";
+      Out << "connectfour_computer_move_seconds_sum " << LatencySum << "\n";
+      Out << "connectfour_computer_move_seconds_count " << LatencyCount << "\n";
     }
 
     /// <summary>
-    /// copy operator
+    /// write the metrics to a file for the node exporter's textfile collector
     /// </summary>
-    /// <param name="original">the instance of the original board to be copied</param>
-    void operator= (const Board& original)
+    /// <param name="Path">the .prom file to replace</param>
+    /// <returns>true if the file was written, false otherwise</returns>
+    bool WriteTextFile(const std::string& Path) const
     {
-      board = original.board;
+      // write a temporary and rename it over the target so a scrape never sees
+      // a partially written file
+      std::string TempPath = Path + ".tmp";
+      {
+        std::ofstream Out(TempPath, std::ios::trunc);
+        Write(Out);
+        if (!Out)
+          return false;
+      }
+
+#ifdef _WIN32
+      return MoveFileExA(TempPath.c_str(), Path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+      return std::rename(TempPath.c_str(), Path.c_str()) == 0;
+#endif
     }
 
+  private:
+    static constexpr std::array<double, 6> LatencyBuckets{ 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1 };
+
+    std::array<uint64_t, 3> Games{};
+    std::array<uint64_t, 2> Moves{};
+    std::array<uint64_t, LatencyBuckets.size()> LatencyCounts{};
+    uint64_t LatencyCount = 0;
+    double LatencySum = 0;
+  };
+
+  /// <summary>
+  /// a structured log of game events.  events are fixed-size records held in
+  /// memory while a game is being played and are only written out by Flush(),
+  /// which runs between games, so logging never puts file i/o on the move path.
+  /// if the buffer fills, further events are counted as dropped rather than
+  /// forcing a write.
+  /// </summary>
+  class EventLog
+  {
+  public:
+    enum class EventType : uint8_t
+    {
+      Start,
+      Move,
+      Result,
+      Error,
+    };
+
+    struct Event
+    {
+      int64_t Time;               // milliseconds since the epoch
+      EventType Type;
+      Board::SpaceState Player;   // mover, winner, or Empty for a draw
+      uint8_t Column;
+      char Message[45];           // truncated error text
+      uint32_t Seed;              // the computer player's seed, for a start event
+    };
+
     /// <summary>
-    /// this function returns an enum indicating the state of the given position
-    /// on the board
+    /// constructor
     /// </summary>
-    /// <param name="Row">0-based index of the row</param>
-    /// <param name="Column">0-based index of the column</param>
-    /// <returns>an enum indicating the state of that position</returns>
-    SpaceState GetSpace(unsigned int Row, unsigned int Column) const
+    /// <param name="LogPath">file to append to; if empty, events are discarded</param>
+    explicit EventLog(std::string LogPath) : Path(std::move(LogPath))
     {
-      if (Row >= Height)
-        throw std::exception{ "Row out of range" };
-      if (Column >= Width)
-        throw std::exception{ "Column out of range" };
+    }
 
-      return board[Row][Column];
+    void LogStart(uint32_t Seed)
+    {
+      Event* e = Push(EventType::Start, Board::SpaceState::Empty, 0, nullptr);
+      if (e != nullptr)
+        e->Seed = Seed;
     }
 
-    /// <summary>
-    /// this function returns a value indicating how many pieces have been
-    /// inserted into this column.
-    /// </summary>
-    /// <param name="Column">0-based index of the column</param>
-    /// <returns>absolute number of pieces existing in the given column</returns>
-    unsigned int GetColumnHeight(unsigned int Column) const
+    void LogMove(Board::MoveType Move, unsigned int Column)
     {
-      if (Column >= Width)
-        throw std::exception{ "Column out of range" };
+      Push(EventType::Move, Board::ConvertMoveToSpaceState(Move), (uint8_t)Column, nullptr);
+    }
 
-      for (int i = Height - 1; i >= 0; --i) {
-        if (board[i][Column] == SpaceState::Empty) {
-          return i;
-        }
-      }
-      return Height; // Column is full
+    void LogResult(Board::SpaceState Winner)
+    {
+      Push(EventType::Result, Winner, 0, nullptr);
     }
 
-    /// <summary>
-    /// check to see if it's possible to make a move to place a token in the given column
-    /// </summary>
-    /// <param name="Column">0-based index of the column</param>
-    /// <returns>true if the move is possible, false otherwise</returns>
-    bool CanMakeMove(unsigned int Column) const
+    void LogError(const char* Message)
     {
-      return GetColumnHeight(Column) < Height;
+      Push(EventType::Error, Board::SpaceState::Empty, 0, Message);
     }
 
     /// <summary>
-    /// if possible, put a token in the given column and adjust the board state accordingly
+    /// append the buffered events to the log file as json lines and empty the buffer
     /// </summary>
-    /// <param name="Move"></param>
-    /// <param name="Column"></param>
-    void MakeMove(MoveType Move, unsigned int Column)
+    /// <returns>true if the events were written, false otherwise</returns>
+    bool Flush()
+    {
+      if (Path.empty())
+      {
+        Count = 0;
+        Dropped = 0;
+        return true;
+      }
+
+      std::ofstream Out(Path, std::ios::app);
+      for (size_t i = 0; i < Count; i++)
+      {
+        WriteEvent(Out, Events[i]);
+      }
+      if (Dropped != 0)
+      {
+        Out << "{\"event\":\"dropped\",\"count\":" << Dropped << "}\n";
+      }
+
+      Count = 0;
+      Dropped = 0;
+      return (bool)Out;
+    }
+
+  private:
+    // returns the buffered event, or nullptr if it was discarded
+    Event* Push(EventType Type, Board::SpaceState Player, uint8_t Column, const char* Message)
     {
-      if (!CanMakeMove(Column))
-        throw std::exception{ "Cannot make move" };
+      if (Path.empty())
+        return nullptr;
+      // the last slot is kept for the result, so a game buried in errors
+      // still records how it ended
+      if (Count == Events.size() || (Count == Events.size() - 1 && Type != EventType::Result))
+      {
+        ++Dropped;
+        return nullptr;
+      }
 
-      auto CurrentHeight = GetColumnHeight(Column);
-      SetSpace(CurrentHeight, Column, ConvertMoveToSpaceState(Move));
+      Event& e = Events[Count++];
+      e.Time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+      e.Type = Type;
+      e.Player = Player;
+      e.Column = Column;
+      e.Seed = 0;
+      e.Message[0] = '\0';
+      if (Message != nullptr)
+      {
+        // string_view's copy rather than strncpy, which msvc's sdl checks reject
+        size_t Length = std::string_view(Message).copy(e.Message, sizeof(e.Message) - 1);
+        e.Message[Length] = '\0';
+      }
+      return &e;
     }
 
-    // output the board to the screen
-    void PrintBoard() const
+    static void WriteEvent(std::ostream& Out, const Event& e)
     {
-      auto GetSpaceStateCharacter = [](SpaceState s)
+      auto PlayerName = [](Board::SpaceState s)
       {
         switch (s)
         {
-        case SpaceState::Empty:
+        case Board::SpaceState::Player1:
+          return "player1";
+        case Board::SpaceState::Player2:
+          return "player2";
+        case Board::SpaceState::Empty:
         default:
-          return ". "; // Changed to '.' for better visibility
-        case SpaceState::Player1:
-          // this creates a string like "<set red>" "x " "<reset color>"
-          return ANSI_COLOR_RED "X " ANSI_COLOR_RESET;
-        case SpaceState::Player2:
-          return "O ";
+          return "none";
         }
       };
 
-      // let's clear the screen
-      printf("\033[2J"); // Clear the entire screen
-      printf("\033[H"); // Reset cursor position to the top-left
-      fflush(stdout);  // Important: Flush the output buffer
-
-      for (unsigned int i = 0; i < Height ; i++) // Iterate from bottom to top
+      Out << "{\"time\":" << e.Time;
+      switch (e.Type)
       {
-        for (unsigned int j = 0; j < Width; j++)
+      case EventType::Start:
+        Out << ",\"event\":\"start\",\"seed\":" << e.Seed;
+        break;
+      case EventType::Move:
+        Out << ",\"event\":\"move\",\"player\":\"" << PlayerName(e.Player) << "\",\"column\":" << e.Column + 1;
+        break;
+      case EventType::Result:
+        Out << ",\"event\":\"result\",\"winner\":\"" << PlayerName(e.Player) << "\"";
+        break;
+      case EventType::Error:
+        Out << ",\"event\":\"error\",\"message\":\"";
+        for (const char* c = e.Message; *c != '\0'; c++)
         {
-          // set the highlight if this location is the most recent move
-          if (IsLastMove(i, j))
-          {
-            std::cout << ANSI_HIGHLIGHT;
-          }
-          std::cout << GetSpaceStateCharacter(GetSpace(i, j));
-          if (IsLastMove(i, j))
-          {
-            std::cout << ANSI_UNDO_HIGHLIGHT;
-          }
+          if (*c == '"' || *c == '\\')
+            Out << '\\';
+          Out << *c;
         }
-        std::cout << std::endl << std::endl;
+        Out << "\"";
+        break;
       }
+      Out << "}\n";
+    }
 
-      for (unsigned int i = 0; i < Width; i++)
-      {
-        std::cout << i + 1 << " ";
-      }
+    // a game is at most Width * Height moves plus its start and result, so
+    // this only overflows when a game is buried in errors
+    std::array<Event, Board::MaxWidth * Board::MaxHeight + 32> Events;
+    size_t Count = 0;
+    uint64_t Dropped = 0;
+    std::string Path;
+  };
+}
+
+/// <summary>
+/// this static method handles input of a column for the player to move
+/// </summary>
+/// <param name="Width">number of columns on the board</param>
+/// <returns>an optional type with the column</returns>
+static std::optional<unsigned int> GetRequestedColumn(unsigned int Width)
+{
+  unsigned int RequestedColumn = 0;
 
-      std::cout << "\n";
+  std::cout << std::endl << "Enter a column between 1 and " << Width << ".  ";
 
-      // make a flowerbox to help separate boards
-      for (unsigned int i = 0; i < Width; i++)
-      {
-        std::cout << "**";
-      }
+  std::cin >> RequestedColumn;
+
+  if (std::cin.eof() || std::cin.bad())
+  {
+    return std::nullopt;
+  }
+  else if (std::cin.fail() || RequestedColumn < 1 || RequestedColumn > Width) // Check for valid input range
+  {
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::cout << "Invalid input. Please enter a column number between 1 and " << Width << ".\n"; // Inform the user
+    return std::nullopt;
+  }
+
+  return RequestedColumn - 1; // Adjust for 0-based indexing
+}
+
+/// <summary>
+/// evaluates one position per input line, given as a move string from the
+/// empty board.  each output line repeats the moves followed by the column
+/// the computer player would choose for the side to move, or the game result
+/// if the position is already decided.  results are written in input order.
+/// </summary>
+/// <param name="In">stream of move strings</param>
+/// <param name="Out">stream for the results</param>
+/// <param name="b">board to play each position onto; its size applies to all of them</param>
+/// <param name="Random">the source for the computer player's random moves</param>
+/// <returns>the number of positions evaluated</returns>
+static size_t RunBatch(std::istream& In, std::ostream& Out, ConnectFour::Board& b, std::mt19937& Random)
+{
+  std::string Line;
+  size_t Count = 0;
 
-      std::cout << "\n";
-      
+  while (std::getline(In, Line))
+  {
+    if (!Line.empty() && Line.back() == '\r')
+      Line.pop_back();
+
+    Out << Line << '\t';
+    ++Count;
+
+    b.Reset();
+    auto Columns = ConnectFour::ParseMoves(Line, b.GetWidth());
+    auto Status = Columns.has_value() ? ConnectFour::PlayMoves(b, *Columns) : std::nullopt;
+
+    if (!Status.has_value())
+    {
+      Out << "invalid\n";
+    }
+    else if (*Status == ConnectFour::Board::GameStatus::Win)
+    {
+      // the winner made the last move
+      Out << (b.GetMoveCount() % 2 == 1 ? "player1" : "player2") << " wins\n";
+    }
+    else if (*Status == ConnectFour::Board::GameStatus::Draw)
+    {
+      Out << "draw\n";
     }
+    else
+    {
+      Out << ConnectFour::ChooseComputerMove(b, ConnectFour::SideToMove(b), Random) + 1 << '\n';
+    }
+  }
 
-    /// <summary>
-    /// check to see if there is a winning state
-    /// </summary>
-    /// <param name="player">a SpaceState enum indicating player</param>
-    /// <returns>true if this is a winning condition, false otherwise</returns>
-    bool CheckWin(SpaceState player) const {
-      // Check horizontal
-      for (int r = 0; r < Height; r++) {
-        for (int c = 0; c <= Width - 4; c++) {
-          if (board[r][c] == player && 
-            board[r][c + 1] == player && 
-            board[r][c + 2] == player && 
-            board[r][c + 3] == player) {
-            return true;
-          }
-        }
-      }
+  return Count;
+}
 
-      // Check vertical
-      for (int c = 0; c < Width; c++) {
-        for (int r = 0; r <= Height - 4; r++) {
-          if (board[r][c] == player && 
-            board[r + 1][c] == player &&
-            board[r + 2][c] == player &&
-            board[r + 3][c] == player) {
-            return true;
-          }
-        }
-      }
+/// <summary>
+/// plays a game without any input or rendering: player 1's moves come from
+/// the list and the computer answers each of them exactly as it does in an
+/// interactive game.  given the seed and the human moves of an interactive
+/// game, this reproduces it move for move.
+/// </summary>
+/// <param name="b">the board to play on; it is reset first</param>
+/// <param name="HumanMoves">player 1's columns, in order</param>
+/// <param name="Random">the computer player's random source, seeded as the game was</param>
+/// <param name="Played">receives both players' moves as a move string</param>
+/// <param name="Render">print the board after every move</param>
+/// <param name="ComputerTime">the time spent choosing the computer's moves is added to this</param>
+/// <returns>the status after the game ended or the moves ran out, or nullopt if a move was illegal</returns>
+static std::optional<ConnectFour::Board::GameStatus> PlayScriptedGame(ConnectFour::Board& b,
+  const std::vector<unsigned int>& HumanMoves, std::mt19937& Random, std::string& Played,
+  bool Render, std::chrono::steady_clock::duration& ComputerTime)
+{
+  b.Reset();
+  Played.clear();
 
-      // Check diagonals (top-left to bottom-right)
-      for (int r = 0; r <= Height - 4; r++) {
-        for (int c = 0; c <= Width - 4; c++) {
-          if (board[r][c] == player &&
-            board[r + 1][c + 1] == player &&
-            board[r + 2][c + 2] == player &&
-            board[r + 3][c + 3] == player) {
-            return true;
-          }
-        }
-      }
+  for (auto Column : HumanMoves)
+  {
+    if (!b.CanMakeMove(Column))
+      return std::nullopt;
 
-      // Check diagonals (bottom-left to top-right)
-      for (int r = 3; r < Height; r++) {
-        for (int c = 0; c <= Width - 4; c++) {
-          if (board[r][c] == player &&
-            board[r - 1][c + 1] == player &&
-            board[r - 2][c + 2] == player &&
-            board[r - 3][c + 3] == player) {
-            return true;
-          }
-        }
-      }
+    auto Status = b.MakeMove(ConnectFour::Board::MoveType::Player1, Column);
+    Played += (char)('1' + Column);
+    if (Render)
+      b.PrintBoard();
+    if (Status != ConnectFour::Board::GameStatus::Ongoing)
+      return Status;
 
-      return false;
+    auto StartTime = std::chrono::steady_clock::now();
+    auto ComputerColumn = ConnectFour::ChooseComputerMove(b, ConnectFour::Board::MoveType::Player2, Random);
+    ComputerTime += std::chrono::steady_clock::now() - StartTime;
+
+    Status = b.MakeMove(ConnectFour::Board::MoveType::Player2, ComputerColumn);
+    Played += (char)('1' + ComputerColumn);
+    if (Render)
+      b.PrintBoard();
+    if (Status != ConnectFour::Board::GameStatus::Ongoing)
+      return Status;
+  }
+
+  return ConnectFour::Board::GameStatus::Ongoing;
+}
+
+/// <summary>
+/// plays one game per script of player 1's moves with PlayScriptedGame.  each
+/// output line repeats the script, then gives every move of the game and how
+/// it ended: a win, a draw, "unfinished" if the script ran out first, or
+/// "invalid".  every game starts from the same seed, so a script's result
+/// doesn't depend on where it is in the list.
+/// </summary>
+/// <param name="Scripts">player 1's moves for each game, as move strings</param>
+/// <param name="Out">stream for the results</param>
+/// <param name="b">board to play each game on; its size applies to all of them</param>
+/// <param name="Seed">the computer player's seed for every game</param>
+/// <param name="Render">print the board after every move</param>
+/// <returns>true if every script was valid</returns>
+static bool RunScriptedGames(const std::vector<std::string>& Scripts, std::ostream& Out,
+  ConnectFour::Board& b, unsigned int Seed, bool Render)
+{
+  std::mt19937 Random;
+  std::string Played;
+  std::chrono::steady_clock::duration ComputerTime{};
+  size_t ComputerMoves = 0;
+  size_t Invalid = 0;
+
+  for (const auto& Script : Scripts)
+  {
+    Random.seed(Seed);
+    auto HumanMoves = ConnectFour::ParseMoves(Script, b.GetWidth());
+    auto Status = HumanMoves.has_value() ?
+      PlayScriptedGame(b, *HumanMoves, Random, Played, Render, ComputerTime) : std::nullopt;
+
+    Out << Script << '\t';
+    if (!Status.has_value())
+    {
+      Out << "invalid\n";
+      ++Invalid;
+      continue;
     }
 
-    static SpaceState ConvertMoveToSpaceState(MoveType Move)
+    // player 1 moves first, so the computer made every second move
+    ComputerMoves += Played.size() / 2;
+
+    Out << Played << '\t';
+    if (*Status == ConnectFour::Board::GameStatus::Win)
+      Out << (Played.size() % 2 == 1 ? "player1" : "player2") << " wins\n";
+    else if (*Status == ConnectFour::Board::GameStatus::Draw)
+      Out << "draw\n";
+    else
+      Out << "unfinished\n";
+  }
+
+  double Seconds = std::chrono::duration<double>(ComputerTime).count();
+  std::cerr << Scripts.size() << " games, " << ComputerMoves << " computer moves in " << Seconds << "s ("
+    << (Seconds > 0 ? ComputerMoves / Seconds : 0) << " moves/sec), seed " << Seed << "\n";
+  return Invalid == 0;
+}
+
+/// <summary>
+/// cross-checks the board's incremental bookkeeping against a brute-force
+/// scan of the cells after one move.  MakeMove decides wins from the lines
+/// through the new token and tracks heights, the move count and the legal
+/// column mask as it goes; none of that may disagree with what GetSpace and
+/// CheckWin see.
+/// </summary>
+/// <param name="b">the board the move was made on</param>
+/// <param name="Mover">the player who made the move</param>
+/// <param name="Status">what MakeMove returned</param>
+/// <returns>a description of the first disagreement, or nullopt if there is none</returns>
+static std::optional<std::string> CheckBoardConsistency(const ConnectFour::Board& b,
+  ConnectFour::Board::MoveType Mover, ConnectFour::Board::GameStatus Status)
+{
+  unsigned int Filled = 0;
+  for (unsigned int Column = 0; Column < b.GetWidth(); Column++)
+  {
+    // the lowest empty row in the column, or Height if it's full
+    unsigned int EmptyRow = b.GetHeight();
+    for (unsigned int Row = 0; Row < b.GetHeight(); Row++)
     {
-      if (Move == MoveType::Player1)
-        return SpaceState::Player1;
+      if (b.GetSpace(Row, Column) == ConnectFour::Board::SpaceState::Empty)
+        EmptyRow = Row;
       else
-        return SpaceState::Player2;
+        Filled++;
     }
 
-  private:
-    // put a token in this place on the board
-    void SetSpace(unsigned int Row, unsigned int Column, SpaceState NewState)
+    if (b.GetColumnHeight(Column) != EmptyRow)
+      return "GetColumnHeight disagrees with the cells in column " + std::to_string(Column + 1);
+    if (b.CanMakeMove(Column) != (EmptyRow != b.GetHeight()))
+      return "CanMakeMove disagrees with the cells in column " + std::to_string(Column + 1);
+    if (((b.LegalMoves() >> Column) & 1) != (b.CanMakeMove(Column) ? 1u : 0u))
+      return "LegalMoves disagrees with CanMakeMove in column " + std::to_string(Column + 1);
+  }
+
+  if (b.GetMoveCount() != Filled)
+    return "GetMoveCount is " + std::to_string(b.GetMoveCount()) + " but " + std::to_string(Filled) + " cells are filled";
+
+  bool Won = b.CheckWin(ConnectFour::Board::ConvertMoveToSpaceState(Mover));
+  if ((Status == ConnectFour::Board::GameStatus::Win) != Won)
+    return Won ? "MakeMove missed a win" : "MakeMove reported a win CheckWin doesn't see";
+
+  bool Full = (Filled == b.GetWidth() * b.GetHeight());
+  if ((Status == ConnectFour::Board::GameStatus::Draw) != (Full && !Won))
+    return "MakeMove's draw result disagrees with the filled cells";
+  if (b.IsFull() != Full)
+    return "IsFull disagrees with the filled cells";
+
+  return std::nullopt;
+}
+
+/// <summary>
+/// plays random games and checks every move with CheckBoardConsistency.  a
+/// third of the moves are also taken back with UndoMove and replayed, which
+/// must give the same result.
+/// </summary>
+/// <param name="Games">number of games to play</param>
+/// <param name="b">the board to play on; its size and connect length are used</param>
+/// <param name="Random">the source for the random moves</param>
+/// <returns>true if no disagreement was found</returns>
+static bool RunSelfCheck(unsigned int Games, ConnectFour::Board& b, std::mt19937& Random)
+{
+  std::uniform_int_distribution<unsigned int> ColumnDistribution(0, b.GetWidth() - 1);
+  uint64_t Moves = 0;
+  std::string Played;
+
+  auto StartTime = std::chrono::steady_clock::now();
+
+  for (unsigned int Game = 0; Game < Games; Game++)
+  {
+    b.Reset();
+    Played.clear();
+
+    auto Status = ConnectFour::Board::GameStatus::Ongoing;
+    while (Status == ConnectFour::Board::GameStatus::Ongoing)
     {
-      if (Row >= Height)
-        throw std::exception{ "Row out of range" };
-      if (Column >= Width)
-        throw std::exception{ "Column out of range" };
+      unsigned int Column = ColumnDistribution(Random);
+      while (!b.CanMakeMove(Column))
+      {
+        Column = (Column + 1) % b.GetWidth();
+      }
 
-      LastMove.x = Column;
-      LastMove.y = Row;
-      LastMove.isInitialized = true;
+      auto Mover = ConnectFour::SideToMove(b);
+      Status = b.MakeMove(Mover, Column);
+      Played += (char)('1' + Column);
+      ++Moves;
 
-      board[Row][Column] = NewState;
+      if (Random() % 3 == 0)
+      {
+        b.UndoMove(Column);
+        if (b.MakeMove(Mover, Column) != Status)
+        {
+          std::cout << "Replaying a move after UndoMove changed its result after " << Played << "\n";
+          return false;
+        }
+      }
+
+      auto Problem = CheckBoardConsistency(b, Mover, Status);
+      if (Problem.has_value())
+      {
+        std::cout << *Problem << " after " << Played << "\n";
+        return false;
+      }
     }
+  }
 
-    /// <summary>
-    /// this checks to see if the given row and column for the board
-    /// are the coordinates of the last move played
-    /// </summary>
-    /// <param name="Row"></param>
-    /// <param name="Column"></param>
-    /// <returns></returns>
-    bool IsLastMove(unsigned int Row, unsigned int Column) const
+  double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+  std::cout << Games << " games, " << Moves << " moves checked in " << Seconds << "s ("
+    << (Seconds > 0 ? Moves / Seconds : 0) << " moves/sec)\n";
+  return true;
+}
+
+/// <summary>
+/// parses a whole string as a non-negative decimal number
+/// </summary>
+/// <param name="Value">the text of the number</param>
+/// <returns>the number, or nullopt if the text isn't one</returns>
+static std::optional<unsigned int> ParseUnsigned(const std::string& Value)
+{
+  try
+  {
+    size_t Used = 0;
+    unsigned long Number = std::stoul(Value, &Used);
+    if (Used != Value.size() || Value[0] == '-' || Number > std::numeric_limits<unsigned int>::max())
+      return std::nullopt;
+    return (unsigned int)Number;
+  }
+  catch (std::exception&)
+  {
+    return std::nullopt;
+  }
+}
+
+/// <summary>
+/// parses a board size given as columns x rows, e.g. "8x7".  columns are
+/// limited to 9 so that every column can be named by one digit.
+/// </summary>
+/// <param name="Size">the value given to --size</param>
+/// <returns>the width and height, or nullopt if the size isn't supported</returns>
+static std::optional<std::pair<unsigned int, unsigned int>> ParseBoardSize(const std::string& Size)
+{
+  auto Separator = Size.find('x');
+  if (Separator == std::string::npos)
+    return std::nullopt;
+
+  try
+  {
+    size_t Used = 0;
+    unsigned long Width = std::stoul(Size.substr(0, Separator), &Used);
+    if (Used != Separator)
+      return std::nullopt;
+    unsigned long Height = std::stoul(Size.substr(Separator + 1), &Used);
+    if (Used != Size.size() - Separator - 1)
+      return std::nullopt;
+
+    if (Width == 0 || Width > ConnectFour::Board::MaxWidth || Height == 0 || Height > ConnectFour::Board::MaxHeight)
+      return std::nullopt;
+
+    return std::make_pair((unsigned int)Width, (unsigned int)Height);
+  }
+  catch (std::exception&)
+  {
+    return std::nullopt;
+  }
+}
+
+// the number of cpus an affinity mask can name
+#ifdef _WIN32
+static const unsigned long MaxCpus = sizeof(DWORD_PTR) * 8;
+#else
+static const unsigned long MaxCpus = CPU_SETSIZE;
+#endif
+
+/// <summary>
+/// parses a cpu list in the format used by the linux sysfs, e.g. "0,2-3"
+/// </summary>
+/// <param name="List">comma separated cpu indices and inclusive ranges</param>
+/// <returns>the cpu indices named by the list, or nullopt if it's malformed or names a cpu past MaxCpus</returns>
+static std::optional<std::vector<unsigned int>> ParseCpuList(const std::string& List)
+{
+  std::vector<unsigned int> Cpus;
+  size_t Start = 0;
+
+  while (Start <= List.size())
+  {
+    auto End = List.find(',', Start);
+    if (End == std::string::npos)
+      End = List.size();
+
+    std::string Token = List.substr(Start, End - Start);
+    auto Dash = Token.find('-');
+    try
     {
-      return (LastMove.isInitialized && LastMove.x == Column &&
-        LastMove.y == Row);
+      size_t Used = 0;
+      unsigned long First = std::stoul(Token.substr(0, Dash), &Used);
+      if (Used != Token.substr(0, Dash).size())
+        return std::nullopt;
+      unsigned long Last = First;
+      if (Dash != std::string::npos)
+      {
+        Last = std::stoul(Token.substr(Dash + 1), &Used);
+        if (Used != Token.size() - Dash - 1)
+          return std::nullopt;
+      }
+      // bound the range before expanding it
+      if (Last < First || Last >= MaxCpus)
+        return std::nullopt;
+      for (auto Cpu = First; Cpu <= Last; Cpu++)
+        Cpus.push_back((unsigned int)Cpu);
+    }
+    catch (std::exception&)
+    {
+      return std::nullopt;
     }
-    
 
-    std::vector<std::vector<SpaceState>> board;
-  };
+    Start = End + 1;
+  }
+
+  return Cpus;
 }
 
 /// <summary>
-/// this static method handles input of a column for the player to move
+/// resolves an --affinity argument into a list of cpus.  the argument is
+/// either a cpu list ("0,2-3") or a numa node ("node:1").
 /// </summary>
-/// <returns>an optional type with the column</returns>
-static std::optional<unsigned int> GetRequestedColumn()
+/// <param name="Spec">the value given to --affinity</param>
+/// <returns>the cpus to pin to, or nullopt if the spec can't be resolved</returns>
+static std::optional<std::vector<unsigned int>> ResolveAffinity(const std::string& Spec)
 {
-  unsigned int RequestedColumn = 0;
+  const std::string NodePrefix = "node:";
+  if (Spec.compare(0, NodePrefix.size(), NodePrefix) != 0)
+    return ParseCpuList(Spec);
 
-  std::cout << std::endl << "Enter a column between 1 and " << ConnectFour::Board::Width << ".  ";
+  auto Node = ParseCpuList(Spec.substr(NodePrefix.size()));
+  if (!Node.has_value() || Node->size() != 1)
+    return std::nullopt;
 
-  std::cin >> RequestedColumn;
+#ifdef _WIN32
+  ULONGLONG Mask = 0;
+  if (!GetNumaNodeProcessorMask((UCHAR)Node->front(), &Mask))
+    return std::nullopt;
 
-  if (std::cin.eof() || std::cin.bad())
+  std::vector<unsigned int> Cpus;
+  for (unsigned int i = 0; i < 64; i++)
   {
+    if (Mask & (1ULL << i))
+      Cpus.push_back(i);
+  }
+  return Cpus;
+#else
+  // the kernel publishes each node's cpus in the same list format
+  std::ifstream CpuListFile("/sys/devices/system/node/node" + std::to_string(Node->front()) + "/cpulist");
+  std::string CpuList;
+  if (!std::getline(CpuListFile, CpuList))
     return std::nullopt;
+  return ParseCpuList(CpuList);
+#endif
+}
+
+/// <summary>
+/// pins the game to the given cpus so the scheduler can't migrate it away
+/// from a warm cache.  threads started afterwards, such as the perft
+/// workers, stay on the same cpus: linux gives a new thread its creator's
+/// mask, and on windows, where new threads take the process mask instead,
+/// the whole process is pinned.
+/// </summary>
+/// <param name="Cpus">the cpus the game may run on</param>
+/// <returns>true if the affinity was applied, false otherwise</returns>
+static bool PinToCpus(const std::vector<unsigned int>& Cpus)
+{
+  if (Cpus.empty())
+    return false;
+
+#ifdef _WIN32
+  DWORD_PTR Mask = 0;
+  for (auto Cpu : Cpus)
+  {
+    if (Cpu >= MaxCpus)
+      return false;
+    Mask |= (DWORD_PTR)1 << Cpu;
   }
-  else if (std::cin.fail() || RequestedColumn < 1 || RequestedColumn > ConnectFour::Board::Width) // Check for valid input range
+  return SetProcessAffinityMask(GetCurrentProcess(), Mask) != 0;
+#else
+  cpu_set_t Set;
+  CPU_ZERO(&Set);
+  for (auto Cpu : Cpus)
   {
-    std::cin.clear();
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    std::cout << "Invalid input. Please enter a column number between 1 and " << ConnectFour::Board::Width << ".\n"; // Inform the user
-    return std::nullopt;
+    if (Cpu >= MaxCpus)
+      return false;
+    CPU_SET(Cpu, &Set);
   }
+  return sched_setaffinity(0, sizeof(Set), &Set) == 0;
+#endif
+}
 
-  return RequestedColumn - 1; // Adjust for 0-based indexing
+// each benchmark is timed this many times; 9 runs give a 95% interval for
+// the median between the 2nd smallest and 2nd largest rates
+static const unsigned int BenchmarkRuns = 9;
+
+// how far a benchmark's median may drop below the baseline before it counts
+// as a regression, as long as its confidence interval has moved too
+static const double RegressionThreshold = 0.05;
+
+static void PrintUsage()
+{
+  std::cout << "Usage: ConnectFour [--affinity <cpu list>|node:<n>] [--metrics <file>] [--log <file>] [--batch <file>|-] [--size <columns>x<rows>] [--connect <n>]\n";
+  std::cout << "                   [--selfcheck <games>] [--bench [--save-baseline <file>] [--compare-baseline <file>]]\n";
+  std::cout << "                   [--seed <n>] [--moves <player 1 moves>] [--moves-file <file>|-] [--render]\n";
+  std::cout << "                   [--perft <depth> [--perft-hash <MB>] [--threads <n>]]\n";
+  std::cout << "  --affinity   pin the game to cpus, e.g. \"0,2-3\", or to a numa node, e.g. \"node:0\"\n";
+  std::cout << "  --metrics    keep a prometheus textfile of game counts and computer move latency\n";
+  std::cout << "  --log        append moves, results and errors to a json lines file after each game\n";
+  std::cout << "  --batch      for each move string read from the file (or stdin), print the computer's reply\n";
+  std::cout << "  --size       play on a different board, e.g. \"8x7\" or \"9x7\"; the default is 7x6\n";
+  std::cout << "  --connect    the number of tokens in a row needed to win; the default is 4\n";
+  std::cout << "  --selfcheck  play random games, checking the board's bookkeeping against a brute-force scan\n";
+  std::cout << "  --bench      time the board, the computer player, self-play and perft on the chosen variant\n";
+  std::cout << "  --save-baseline     write the --bench results to a file\n";
+  std::cout << "  --compare-baseline  compare --bench with a saved file; exits with 1 on a regression\n";
+  std::cout << "  --seed       seed the computer player; each finished game prints its seed so it can be replayed\n";
+  std::cout << "  --moves      replay a game from player 1's moves, e.g. \"4453\", answering with the computer player\n";
+  std::cout << "  --moves-file replay a game for each line of player 1's moves in the file (or stdin)\n";
+  std::cout << "  --render     print the board after every move of a replayed game\n";
+  std::cout << "  --perft      count the move sequences of the given length from the empty board, per first move\n";
+  std::cout << "  --perft-hash share a hash of that many MB between the threads so each transposition is counted once\n";
+  std::cout << "  --threads    the number of threads for --perft; the default is one per cpu\n";
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-  ConnectFour::Board b;
+  ConnectFour::Metrics metrics;
+  std::string MetricsPath;
+  std::string LogPath;
+  std::optional<std::string> BatchPath;
+  std::optional<unsigned int> SelfCheckGames;
+  bool RunBench = false;
+  std::string SaveBaselinePath;
+  std::string CompareBaselinePath;
+  std::optional<unsigned int> Seed;
+  std::vector<std::string> Scripts;
+  std::optional<std::string> ScriptPath;
+  bool Render = false;
+  std::optional<unsigned int> PerftDepth;
+  unsigned int PerftHashMegabytes = 0;
+  unsigned int Threads = std::max(1u, std::thread::hardware_concurrency());
+  unsigned int BoardWidth = ConnectFour::Board::DefaultWidth;
+  unsigned int BoardHeight = ConnectFour::Board::DefaultHeight;
+  unsigned int ConnectLength = ConnectFour::Board::DefaultConnectLength;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string Arg = argv[i];
+
+    if (Arg == "--affinity" && i + 1 < argc)
+    {
+      auto Cpus = ResolveAffinity(argv[++i]);
+      if (!Cpus.has_value() || !PinToCpus(*Cpus))
+      {
+        std::cout << "Unable to set cpu affinity to " << argv[i] << "\n";
+        return 1;
+      }
+    }
+    else if (Arg == "--metrics" && i + 1 < argc)
+    {
+      MetricsPath = argv[++i];
+    }
+    else if (Arg == "--log" && i + 1 < argc)
+    {
+      LogPath = argv[++i];
+    }
+    else if (Arg == "--batch" && i + 1 < argc)
+    {
+      BatchPath = argv[++i];
+    }
+    else if (Arg == "--bench")
+    {
+      RunBench = true;
+    }
+    else if (Arg == "--save-baseline" && i + 1 < argc)
+    {
+      SaveBaselinePath = argv[++i];
+    }
+    else if (Arg == "--compare-baseline" && i + 1 < argc)
+    {
+      CompareBaselinePath = argv[++i];
+    }
+    else if (Arg == "--selfcheck" && i + 1 < argc)
+    {
+      SelfCheckGames = ParseUnsigned(argv[++i]);
+      if (!SelfCheckGames.has_value())
+      {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if (Arg == "--seed" && i + 1 < argc)
+    {
+      Seed = ParseUnsigned(argv[++i]);
+      if (!Seed.has_value())
+      {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if (Arg == "--moves" && i + 1 < argc)
+    {
+      Scripts.push_back(argv[++i]);
+    }
+    else if (Arg == "--moves-file" && i + 1 < argc)
+    {
+      ScriptPath = argv[++i];
+    }
+    else if (Arg == "--render")
+    {
+      Render = true;
+    }
+    else if (Arg == "--perft" && i + 1 < argc)
+    {
+      PerftDepth = ParseUnsigned(argv[++i]);
+      if (!PerftDepth.has_value())
+      {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if (Arg == "--perft-hash" && i + 1 < argc)
+    {
+      // the size in bytes has to fit a size_t, which is only 32 bits on win32
+      auto Megabytes = ParseUnsigned(argv[++i]);
+      if (!Megabytes.has_value() || *Megabytes > (std::numeric_limits<size_t>::max() >> 20))
+      {
+        std::cout << "Unsupported perft hash size " << argv[i] << "\n";
+        return 1;
+      }
+      PerftHashMegabytes = *Megabytes;
+    }
+    else if (Arg == "--threads" && i + 1 < argc)
+    {
+      auto Count = ParseUnsigned(argv[++i]);
+      if (!Count.has_value() || *Count == 0)
+      {
+        PrintUsage();
+        return 1;
+      }
+      Threads = *Count;
+    }
+    else if (Arg == "--size" && i + 1 < argc)
+    {
+      auto Size = ParseBoardSize(argv[++i]);
+      if (!Size.has_value())
+      {
+        std::cout << "Unsupported board size " << argv[i] << "\n";
+        return 1;
+      }
+      BoardWidth = Size->first;
+      BoardHeight = Size->second;
+    }
+    else if (Arg == "--connect" && i + 1 < argc)
+    {
+      auto Length = ParseUnsigned(argv[++i]);
+      if (!Length.has_value() || *Length < ConnectFour::Board::MinConnectLength)
+      {
+        std::cout << "Unsupported connect length " << argv[i] << "\n";
+        return 1;
+      }
+      ConnectLength = *Length;
+    }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  // the textfile is rewritten after every computer move and every finished game
+  auto ExportMetrics = [&]()
+  {
+    if (!MetricsPath.empty() && !metrics.WriteTextFile(MetricsPath))
+      std::cout << "Unable to write metrics to " << MetricsPath << "\n";
+  };
 
-  srand((unsigned int)std::time(0));
+  if (BoardWidth < ConnectLength || BoardHeight < ConnectLength)
+  {
+    std::cout << "A " << BoardWidth << "x" << BoardHeight << " board is too small to connect " << ConnectLength << "\n";
+    return 1;
+  }
+
+  // every use of the random source below starts from this seed, so any run
+  // can be repeated exactly by passing it back with --seed
+  unsigned int SessionSeed = Seed.has_value() ? *Seed : (unsigned int)std::time(0);
+  std::mt19937 Random(SessionSeed);
+  ConnectFour::Board b(BoardWidth, BoardHeight, ConnectLength);
+
+  if (RunBench)
+  {
+    std::optional<ConnectFour::BenchmarkBaseline> Baseline;
+    if (!CompareBaselinePath.empty())
+    {
+      Baseline = ConnectFour::LoadBaseline(CompareBaselinePath);
+      if (!Baseline.has_value())
+      {
+        std::cout << "Unable to read the baseline " << CompareBaselinePath << "\n";
+        return 1;
+      }
+
+      // rates on another variant aren't comparable, so don't report them as regressions
+      if (Baseline->Width != b.GetWidth() || Baseline->Height != b.GetHeight() ||
+        Baseline->ConnectLength != b.GetConnectLength())
+      {
+        std::cout << "The baseline " << CompareBaselinePath << " was measured on " << Baseline->Width << "x"
+          << Baseline->Height << " connect " << Baseline->ConnectLength << ", not " << b.GetWidth() << "x"
+          << b.GetHeight() << " connect " << b.GetConnectLength() << "\n";
+        return 1;
+      }
+    }
+
+    auto Results = ConnectFour::RunBenchmarks(b, BenchmarkRuns);
+    auto Regressions = ConnectFour::ReportBenchmarks(Results, Baseline ? &Baseline->Results : nullptr, RegressionThreshold);
+
+    if (!SaveBaselinePath.empty() && !ConnectFour::SaveBaseline(SaveBaselinePath, b, Results))
+    {
+      std::cout << "Unable to write the baseline " << SaveBaselinePath << "\n";
+      return 1;
+    }
+    return Regressions == 0 ? 0 : 1;
+  }
+
+  if (PerftDepth.has_value())
+  {
+    if (PerftHashMegabytes != 0 && !ConnectFour::PerftHashFits(b))
+    {
+      std::cout << "The perft hash needs columns x (rows + 1) to be at most 64\n";
+      return 1;
+    }
+
+    auto StartTime = std::chrono::steady_clock::now();
+    ConnectFour::PerftResult Result;
+    try
+    {
+      Result = ConnectFour::Perft(b, *PerftDepth, Threads, (size_t)PerftHashMegabytes << 20);
+    }
+    catch (std::bad_alloc&)
+    {
+      // the hash is the only large allocation, and it's made before counting starts
+      std::cout << "Unable to allocate the perft hash\n";
+      return 1;
+    }
+    double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+    for (unsigned int Column = 0; Column < b.GetWidth(); Column++)
+    {
+      std::cout << Column + 1 << ": " << Result.Divide[Column] << "\n";
+    }
+    std::cout << "perft " << *PerftDepth << ": " << Result.Nodes << " in " << Seconds << "s ("
+      << (Seconds > 0 ? Result.Nodes / Seconds : 0) << " nodes/sec), " << Result.HashHits << " hash hits\n";
+    return 0;
+  }
+
+  if (SelfCheckGames.has_value())
+  {
+    if (RunSelfCheck(*SelfCheckGames, b, Random))
+      return 0;
+    std::cout << "Repeat this run with the same options and --seed " << SessionSeed << "\n";
+    return 1;
+  }
+
+  if (ScriptPath.has_value())
+  {
+    std::ifstream ScriptFile;
+    if (*ScriptPath != "-")
+    {
+      ScriptFile.open(*ScriptPath);
+      if (!ScriptFile)
+      {
+        std::cout << "Unable to open " << *ScriptPath << "\n";
+        return 1;
+      }
+    }
+
+    // read the whole file first so that none of the i/o lands between games
+    std::istream& In = (*ScriptPath == "-") ? std::cin : ScriptFile;
+    std::string Line;
+    while (std::getline(In, Line))
+    {
+      if (!Line.empty() && Line.back() == '\r')
+        Line.pop_back();
+      Scripts.push_back(Line);
+    }
+  }
+
+  if (!Scripts.empty())
+  {
+    return RunScriptedGames(Scripts, std::cout, b, SessionSeed, Render) ? 0 : 1;
+  }
+
+  if (BatchPath.has_value())
+  {
+    std::ifstream BatchFile;
+    if (*BatchPath != "-")
+    {
+      BatchFile.open(*BatchPath);
+      if (!BatchFile)
+      {
+        std::cout << "Unable to open " << *BatchPath << "\n";
+        return 1;
+      }
+    }
+
+    auto StartTime = std::chrono::steady_clock::now();
+    auto Count = RunBatch(*BatchPath == "-" ? std::cin : BatchFile, std::cout, b, Random);
+    double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+    std::cerr << Count << " positions in " << Seconds << "s (" << (Seconds > 0 ? Count / Seconds : 0) << " positions/sec), seed " << SessionSeed << "\n";
+    return 0;
+  }
+
+  ConnectFour::EventLog Log(LogPath);
+
+  // each game reseeds the computer player so that it can be replayed on its
+  // own from its seed and player 1's moves, without the games before it
+  unsigned int GameSeed = SessionSeed;
+  std::string HumanMoves;
+  Random.seed(GameSeed);
+  Log.LogStart(GameSeed);
 
   // there may be nested places where a game over condition occurs, so throw an exception
   // to stop the loop
@@ -328,21 +1117,32 @@ int main()
 
       b.PrintBoard();
 
+      auto Status = ConnectFour::Board::GameStatus::Ongoing;
       while (true) { // Loop until valid input
-        auto Column = GetRequestedColumn();
+        auto Column = GetRequestedColumn(b.GetWidth());
+        if (std::cin.eof() || std::cin.bad()) {
+          // the input is gone, e.g. the end of a file piped in, so there is
+          // nobody left to play
+          Log.Flush();
+          return 0;
+        }
         if (Column.has_value()) {
           try {
-            b.MakeMove(currentPlayer, *Column);
+            Status = b.MakeMove(currentPlayer, *Column);
+            HumanMoves += (char)('1' + *Column);
+            metrics.RecordMove(currentPlayer);
+            Log.LogMove(currentPlayer, *Column);
             break; // Exit input loop if valid move is made
           }
           catch (std::exception& e) {
             std::cout << e.what() << std::endl;
+            Log.LogError(e.what());
 
           }
         }
       }
 
-      if (b.CheckWin(ConnectFour::Board::ConvertMoveToSpaceState(currentPlayer))) {
+      if (Status == ConnectFour::Board::GameStatus::Win) {
         b.PrintBoard();
         std::cout << (currentPlayer == ConnectFour::Board::MoveType::Player1 ? "Player 1" : "Player 2") << " wins!\n";
         throw ConnectFour::GameOverException();
@@ -352,15 +1152,7 @@ int main()
         currentPlayer = (currentPlayer == ConnectFour::Board::MoveType::Player1) ?
           ConnectFour::Board::MoveType::Player2 : ConnectFour::Board::MoveType::Player1;
 
-        // Check for a draw
-        bool isDraw = true;
-        for (int c = 0; c < b.Width; ++c) {
-          if (b.CanMakeMove(c)) {
-            isDraw = false;
-            break;
-          }
-        }
-        if (isDraw) {
+        if (Status == ConnectFour::Board::GameStatus::Draw) {
           b.PrintBoard();
           std::cout << "It's a draw!" << std::endl;
           throw ConnectFour::GameOverException();
@@ -368,90 +1160,27 @@ int main()
         // if it's the computer's turn, then do some extra logic
         else if (currentPlayer == ConnectFour::Board::MoveType::Player2)
         {
-          int autoMove = 1 + (rand() % b.Width);
-
           b.PrintBoard();
 
-          // iterate through the possible board plays, looking for either a winning play,
-          // or a blocking play, or a random play if neither of those are available.  To
-          // make the game more difficult, this could look to see if a move isn't likely
-          // to cause a win..
-
-          // look for winning play
-          for (int i = 0; i < b.Width; i++)
-          {
-            // create a copy of the board
-            ConnectFour::Board boardWin;
-            boardWin = b;
-
-            // make a move, if possible, and then check for a win
-            if (boardWin.CanMakeMove(i))
-            {
-              boardWin.MakeMove(ConnectFour::Board::MoveType::Player2, i);
-
-              // if it's a win, do the win logic
-              if (boardWin.CheckWin(ConnectFour::Board::SpaceState::Player2))
-              {
-                b.MakeMove(ConnectFour::Board::MoveType::Player2, i);
-                b.PrintBoard();
-                std::cout << "Player 2 wins!" << std::endl;
-                throw ConnectFour::GameOverException();
-              }
-            }
-          } // end for loop
-
-          // look for a blocking play
-          bool bFoundBlock = false;
-          for (int i = 0; i < b.Width; i++)
-          {
-            // create a copy of the board
-            ConnectFour::Board boardWin;
-            boardWin = b;
-
-            // make a move, if possible, and then check for a win by player 1
-            if (boardWin.CanMakeMove(i))
-            {
-              boardWin.MakeMove(ConnectFour::Board::MoveType::Player1, i);
-              if (boardWin.CheckWin(ConnectFour::Board::SpaceState::Player1))
-              {
-                // let's block player 1
-                b.MakeMove(ConnectFour::Board::MoveType::Player2, i);
-                bFoundBlock = true;
-
-                // if this move will win the game, do the win
-                if (b.CheckWin(ConnectFour::Board::SpaceState::Player2))
-                {
-                  b.PrintBoard();
-                  std::cout << "Player 2 wins!" << std::endl;
-                  throw ConnectFour::GameOverException();
-                }
-                break;
-              }
-            }
-          } // end for loop
-
-          // if a blocking move was not found, then make a random move
-          if (!bFoundBlock)
-          {
-            // skip columns till one is available.  since it's not a draw, there must
-            // be an available column
-            while (!b.CanMakeMove(autoMove - 1))
-            {
-              autoMove++;
-              if (autoMove > b.Width)
-              {
-                autoMove = 1;   // autoMove is 1-indexed
-              }
-            }
-
-            b.MakeMove(ConnectFour::Board::MoveType::Player2, autoMove - 1);
-          }
+          auto StartTime = std::chrono::steady_clock::now();
+          auto ComputerColumn = ConnectFour::ChooseComputerMove(b, ConnectFour::Board::MoveType::Player2, Random);
+          Status = b.MakeMove(ConnectFour::Board::MoveType::Player2, ComputerColumn);
+          metrics.RecordComputerLatency(std::chrono::steady_clock::now() - StartTime);
+          metrics.RecordMove(ConnectFour::Board::MoveType::Player2);
+          Log.LogMove(ConnectFour::Board::MoveType::Player2, ComputerColumn);
 
-          if (b.CheckWin(ConnectFour::Board::ConvertMoveToSpaceState(ConnectFour::Board::MoveType::Player2))) {
+          if (Status == ConnectFour::Board::GameStatus::Win) {
             b.PrintBoard();
             std::cout << "Player 2 wins!" << std::endl;
             throw ConnectFour::GameOverException();
           }
+          else if (Status == ConnectFour::Board::GameStatus::Draw) {
+            b.PrintBoard();
+            std::cout << "It's a draw!" << std::endl;
+            throw ConnectFour::GameOverException();
+          }
+
+          ExportMetrics();
 
           // switch player back to player 1
           currentPlayer = ConnectFour::Board::MoveType::Player1;
@@ -462,22 +1191,47 @@ int main()
 
     catch (ConnectFour::GameOverException exc)
     {
+      // tally the result before the board is thrown away
+      auto Winner = ConnectFour::Board::SpaceState::Empty;
+      if (b.CheckWin(ConnectFour::Board::SpaceState::Player1))
+        Winner = ConnectFour::Board::SpaceState::Player1;
+      else if (b.CheckWin(ConnectFour::Board::SpaceState::Player2))
+        Winner = ConnectFour::Board::SpaceState::Player2;
+      metrics.RecordGame(Winner);
+      ExportMetrics();
+
+      // the game is over, so this is the time to pay for the log i/o
+      Log.LogResult(Winner);
+      if (!Log.Flush())
+        std::cout << "Unable to write the log to " << LogPath << "\n";
+
+      std::cout << "Replay this game with";
+      if (b.GetWidth() != ConnectFour::Board::DefaultWidth || b.GetHeight() != ConnectFour::Board::DefaultHeight)
+        std::cout << " --size " << b.GetWidth() << "x" << b.GetHeight();
+      if (b.GetConnectLength() != ConnectFour::Board::DefaultConnectLength)
+        std::cout << " --connect " << b.GetConnectLength();
+      std::cout << " --seed " << GameSeed << " --moves " << HumanMoves << "\n";
+
       char temp;
 
       std::cin >> temp;
 
-      // reset the board
-      ConnectFour::Board newBoard;
-      b = newBoard;
+      // reset the board in place for the next game.  everything else built up
+      // during the session (metrics, the log) carries on into it
+      b.Reset();
+      HumanMoves.clear();
+      Random.seed(++GameSeed);
+      Log.LogStart(GameSeed);
 
       // all done so beep 4 times for losers
-      if (b.CheckWin(ConnectFour::Board::ConvertMoveToSpaceState(ConnectFour::Board::MoveType::Player2))) {
+      if (Winner == ConnectFour::Board::SpaceState::Player2) {
         printf("\a\a\a\a"); // The '\a' character is the "alert" or beep character.
         fflush(stdout);   // don't delay the beep
       }
     }
     catch (std::exception exs)
     {
+      Log.LogError(exs.what());
       printf(exs.what());
     }
   }
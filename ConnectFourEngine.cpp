@@ -0,0 +1,133 @@
+#include "ConnectFourEngine.h"
+#include "ComputerPlayer.h"
+
+struct CfEngine
+{
+  CfEngine(unsigned int Width, unsigned int Height, unsigned int ConnectLength, unsigned int Seed) :
+    Position(Width, Height, ConnectLength), Scratch(Width, Height, ConnectLength), Random(Seed)
+  {
+  }
+
+  ConnectFour::Board Position;
+  ConnectFour::Board::GameStatus Status = ConnectFour::Board::GameStatus::Ongoing;
+  ConnectFour::Board Scratch;   // working board for batch evaluation
+  std::mt19937 Random;
+};
+
+/// <summary>
+/// plays a move string onto an empty board
+/// </summary>
+/// <param name="b">the board to set; it's left empty if the moves are illegal</param>
+/// <param name="Moves">1-based columns, one per character</param>
+/// <returns>the status after the last move, or nullopt if the moves are illegal</returns>
+static std::optional<ConnectFour::Board::GameStatus> SetBoard(ConnectFour::Board& b, const char* Moves)
+{
+  b.Reset();
+
+  auto Columns = ConnectFour::ParseMoves(Moves, b.GetWidth());
+  auto Status = Columns.has_value() ? ConnectFour::PlayMoves(b, *Columns) : std::nullopt;
+  if (!Status.has_value())
+    b.Reset();
+
+  return Status;
+}
+
+/// <summary>
+/// the computer player's move for the side to move
+/// </summary>
+/// <returns>a 0-based column, or CF_GAME_OVER if the game has ended</returns>
+static int BestMove(const ConnectFour::Board& b, ConnectFour::Board::GameStatus Status, std::mt19937& Random)
+{
+  if (Status != ConnectFour::Board::GameStatus::Ongoing)
+    return CF_GAME_OVER;
+
+  return (int)ConnectFour::ChooseComputerMove(b, ConnectFour::SideToMove(b), Random);
+}
+
+CfEngine* CfCreateEngine(unsigned int Seed)
+{
+  return CfCreateVariantEngine(ConnectFour::Board::DefaultWidth, ConnectFour::Board::DefaultHeight,
+    ConnectFour::Board::DefaultConnectLength, Seed);
+}
+
+CfEngine* CfCreateVariantEngine(unsigned int Width, unsigned int Height, unsigned int ConnectLength, unsigned int Seed)
+{
+  // move strings name columns with single digits, and the board caps the height
+  if (Width > ConnectFour::Board::MaxWidth || Height > ConnectFour::Board::MaxHeight)
+    return nullptr;
+
+  try
+  {
+    return new CfEngine(Width, Height, ConnectLength, Seed);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+void CfDestroyEngine(CfEngine* Engine)
+{
+  delete Engine;
+}
+
+int CfSetPosition(CfEngine* Engine, const char* Moves)
+{
+  if (Engine == nullptr || Moves == nullptr)
+    return CF_INVALID_ARGUMENT;
+
+  try
+  {
+    auto Status = SetBoard(Engine->Position, Moves);
+    Engine->Status = Status.value_or(ConnectFour::Board::GameStatus::Ongoing);
+    return Status.has_value() ? CF_OK : CF_ILLEGAL_MOVES;
+  }
+  catch (...)
+  {
+    Engine->Position.Reset();
+    Engine->Status = ConnectFour::Board::GameStatus::Ongoing;
+    return CF_INTERNAL_ERROR;
+  }
+}
+
+int CfBestMove(CfEngine* Engine)
+{
+  if (Engine == nullptr)
+    return CF_INVALID_ARGUMENT;
+
+  try
+  {
+    return BestMove(Engine->Position, Engine->Status, Engine->Random);
+  }
+  catch (...)
+  {
+    return CF_INTERNAL_ERROR;
+  }
+}
+
+int CfEvaluateBatch(CfEngine* Engine, const char* const* Positions, size_t Count, int* Results)
+{
+  if (Engine == nullptr || Positions == nullptr || Results == nullptr)
+    return CF_INVALID_ARGUMENT;
+
+  for (size_t i = 0; i < Count; i++)
+  {
+    try
+    {
+      if (Positions[i] == nullptr)
+      {
+        Results[i] = CF_INVALID_ARGUMENT;
+        continue;
+      }
+
+      auto Status = SetBoard(Engine->Scratch, Positions[i]);
+      Results[i] = Status.has_value() ? BestMove(Engine->Scratch, *Status, Engine->Random) : CF_ILLEGAL_MOVES;
+    }
+    catch (...)
+    {
+      Results[i] = CF_INTERNAL_ERROR;
+    }
+  }
+
+  return CF_OK;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ * a C interface to the board and the computer player, for programs that want
+ * to run the engine in-process instead of driving the console game.
+ *
+ * every engine handle owns its own board and random number generator, so
+ * separate handles can be used from separate threads at the same time.  a
+ * single handle must not be used by two threads at once.
+ */
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#ifdef CONNECTFOUR_ENGINE_EXPORTS
+#define CONNECTFOUR_API __declspec(dllexport)
+#else
+#define CONNECTFOUR_API __declspec(dllimport)
+#endif
+#else
+#define CONNECTFOUR_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* return codes; columns are returned as non-negative 0-based indices */
+#define CF_OK                0
+#define CF_INVALID_ARGUMENT -1   /* a null handle or pointer */
+#define CF_ILLEGAL_MOVES    -2   /* the move string isn't a legal game */
+#define CF_GAME_OVER        -3   /* the position is already won or drawn */
+#define CF_INTERNAL_ERROR   -4
+
+typedef struct CfEngine CfEngine;
+
+/* creates an engine at the empty 7x6 board; returns null if it can't be allocated */
+CONNECTFOUR_API CfEngine* CfCreateEngine(unsigned int Seed);
+
+/*
+ * creates an engine for a Width x Height board where ConnectLength tokens in
+ * a row win.  returns null if it can't be allocated or the variant isn't
+ * supported: at most 9 columns and 16 rows, a connect length of at least 3,
+ * and a board at least ConnectLength wide and high.
+ */
+CONNECTFOUR_API CfEngine* CfCreateVariantEngine(unsigned int Width, unsigned int Height, unsigned int ConnectLength, unsigned int Seed);
+
+CONNECTFOUR_API void CfDestroyEngine(CfEngine* Engine);
+
+/*
+ * sets the engine's position from a move string of 1-based columns, e.g.
+ * "44536".  on failure the engine is left at the empty board.
+ */
+CONNECTFOUR_API int CfSetPosition(CfEngine* Engine, const char* Moves);
+
+/* returns the 0-based column the computer player chooses for the side to move */
+CONNECTFOUR_API int CfBestMove(CfEngine* Engine);
+
+/*
+ * evaluates Count move strings, writing the best move (or an error code) for
+ * Positions[i] into Results[i].  the strings are read in place; the engine's
+ * own position is left unchanged.  returns CF_OK, or CF_INVALID_ARGUMENT if
+ * the engine or either array is null.
+ */
+CONNECTFOUR_API int CfEvaluateBatch(CfEngine* Engine, const char* const* Positions, size_t Count, int* Results);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,233 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "Perft.h"
+#include "ComputerPlayer.h"
+
+namespace ConnectFour
+{
+  // remaining depths below this are cheaper to count again than to look up
+  static const unsigned int MinHashDepth = 3;
+
+  // subtree counts shared by every thread of one perft.  a key fixes the
+  // number of tokens on the board, and with it the depth left to count, so
+  // the key alone identifies a count.  the table is split between a fixed
+  // number of locks so that threads rarely wait for each other.
+  class PerftHash
+  {
+  public:
+    explicit PerftHash(size_t Bytes)
+    {
+      size_t Count = 1;
+      while (Count * 2 * sizeof(Entry) <= Bytes)
+      {
+        Count *= 2;
+      }
+      Entries.resize(Count);
+      Mask = Count - 1;
+    }
+
+    bool Find(uint64_t Key, uint64_t& Count)
+    {
+      size_t Index = Slot(Key);
+      std::lock_guard<std::mutex> Lock(Locks[Index % Locks.size()]);
+      if (Entries[Index].Key != Key)
+        return false;
+      Count = Entries[Index].Count;
+      return true;
+    }
+
+    // the newest count always replaces whatever was in its slot
+    void Store(uint64_t Key, uint64_t Count)
+    {
+      size_t Index = Slot(Key);
+      std::lock_guard<std::mutex> Lock(Locks[Index % Locks.size()]);
+      Entries[Index].Key = Key;
+      Entries[Index].Count = Count;
+    }
+
+  private:
+    struct Entry
+    {
+      uint64_t Key = 0;     // 0 is never a position's key, so it marks an empty slot
+      uint64_t Count = 0;
+    };
+
+    size_t Slot(uint64_t Key) const
+    {
+      // spread the column bits over the table
+      return (size_t)((Key * 0x9E3779B97F4A7C15ull) >> 20) & Mask;
+    }
+
+    std::vector<Entry> Entries;
+    size_t Mask;
+    std::array<std::mutex, 1024> Locks;
+  };
+
+  // each column is Height + 1 bits from the bottom up: a bit per token, set
+  // for player 1, then a 1 just above the top token.  every position has
+  // its own key, and the empty board's is the 1s of the empty columns.
+  static uint64_t PositionKey(const Board& b)
+  {
+    uint64_t Key = 0;
+    for (unsigned int Column = 0; Column < b.GetWidth(); Column++)
+    {
+      unsigned int Base = Column * (b.GetHeight() + 1);
+      unsigned int Tokens = 0;
+      for (unsigned int Row = b.GetHeight(); Row-- > 0; )
+      {
+        auto Space = b.GetSpace(Row, Column);
+        if (Space == Board::SpaceState::Empty)
+          break;
+        if (Space == Board::SpaceState::Player1)
+          Key |= 1ull << (Base + Tokens);
+        Tokens++;
+      }
+      Key |= 1ull << (Base + Tokens);
+    }
+    return Key;
+  }
+
+  static unsigned int CountColumns(uint32_t Mask)
+  {
+    unsigned int Count = 0;
+    for (; Mask != 0; Mask &= Mask - 1)
+    {
+      Count++;
+    }
+    return Count;
+  }
+
+  // one thread's walk of the tree, on its own board
+  struct PerftWalker
+  {
+    Board b;
+    uint64_t Key;
+    PerftHash* Hash;
+    uint64_t HashHits = 0;
+
+    // makes the move, keeping the key in step.  returns the previous key
+    // for UndoMove
+    uint64_t MakeMove(unsigned int Column, Board::GameStatus& Status)
+    {
+      uint64_t Previous = Key;
+      if (Hash != nullptr)
+      {
+        // the token goes where the column's top 1 is, and the 1 moves up
+        unsigned int Bit = Column * (b.GetHeight() + 1) + (b.GetHeight() - 1 - b.GetColumnHeight(Column));
+        Key ^= 1ull << Bit;
+        Key |= 1ull << (Bit + 1);
+        if (SideToMove(b) == Board::MoveType::Player1)
+          Key |= 1ull << Bit;
+      }
+      Status = b.MakeMove(SideToMove(b), Column);
+      return Previous;
+    }
+
+    void UndoMove(unsigned int Column, uint64_t Previous)
+    {
+      b.UndoMove(Column);
+      Key = Previous;
+    }
+
+    uint64_t Count(unsigned int Depth)
+    {
+      if (Depth == 0)
+        return 1;
+
+      // every legal last move ends a sequence, won or not
+      if (Depth == 1)
+        return CountColumns(b.LegalMoves());
+
+      uint64_t Nodes = 0;
+      bool UseHash = (Hash != nullptr && Depth >= MinHashDepth);
+      if (UseHash && Hash->Find(Key, Nodes))
+      {
+        HashHits++;
+        return Nodes;
+      }
+
+      for (unsigned int Column = 0; Column < b.GetWidth(); Column++)
+      {
+        if (!b.CanMakeMove(Column))
+          continue;
+
+        auto Status = Board::GameStatus::Ongoing;
+        uint64_t Previous = MakeMove(Column, Status);
+        if (Status == Board::GameStatus::Ongoing)
+          Nodes += Count(Depth - 1);
+        UndoMove(Column, Previous);
+      }
+
+      if (UseHash)
+        Hash->Store(Key, Nodes);
+      return Nodes;
+    }
+  };
+
+  bool PerftHashFits(const Board& Position)
+  {
+    return Position.GetWidth() * (Position.GetHeight() + 1) <= 64;
+  }
+
+  PerftResult Perft(const Board& Position, unsigned int Depth, unsigned int Threads, size_t HashBytes)
+  {
+    if (HashBytes != 0 && !PerftHashFits(Position))
+      throw std::exception{ "The perft hash doesn't fit this board" };
+
+    PerftResult Result{ 0, std::vector<uint64_t>(Position.GetWidth(), 0), 0 };
+    if (Depth == 0)
+    {
+      Result.Nodes = 1;
+      return Result;
+    }
+
+    std::optional<PerftHash> Hash;
+    if (HashBytes != 0)
+      Hash.emplace(HashBytes);
+
+    // the threads take root columns in turn until there are none left
+    std::atomic<unsigned int> NextColumn{ 0 };
+    std::atomic<uint64_t> HashHits{ 0 };
+    auto Work = [&]()
+    {
+      PerftWalker Walker{ Position, PositionKey(Position), Hash ? &*Hash : nullptr };
+
+      for (unsigned int Column = NextColumn++; Column < Position.GetWidth(); Column = NextColumn++)
+      {
+        if (!Walker.b.CanMakeMove(Column))
+          continue;
+
+        auto Status = Board::GameStatus::Ongoing;
+        uint64_t Previous = Walker.MakeMove(Column, Status);
+        if (Depth == 1 || Status == Board::GameStatus::Ongoing)
+          Result.Divide[Column] = Walker.Count(Depth - 1);
+        Walker.UndoMove(Column, Previous);
+      }
+
+      HashHits += Walker.HashHits;
+    };
+
+    Threads = std::max(1u, std::min(Threads, Position.GetWidth()));
+    std::vector<std::thread> Workers;
+    for (unsigned int i = 1; i < Threads; i++)
+    {
+      Workers.emplace_back(Work);
+    }
+    Work();
+    for (auto& Worker : Workers)
+    {
+      Worker.join();
+    }
+
+    for (auto Count : Result.Divide)
+    {
+      Result.Nodes += Count;
+    }
+    Result.HashHits = HashHits;
+    return Result;
+  }
+}
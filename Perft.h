@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+namespace ConnectFour
+{
+  /// <summary>
+  /// the move-path count of one perft run
+  /// </summary>
+  struct PerftResult
+  {
+    uint64_t Nodes;                  // move sequences of the full depth
+    std::vector<uint64_t> Divide;    // the part of Nodes below each root column; 0 if it's full
+    uint64_t HashHits;               // subtree counts taken from the hash instead of searched
+  };
+
+  /// <summary>
+  /// the hash keys a position exactly by giving each column Height + 1 bits,
+  /// so it only fits boards where Width * (Height + 1) is at most 64
+  /// </summary>
+  bool PerftHashFits(const Board& Position);
+
+  /// <summary>
+  /// counts the move sequences of exactly Depth moves from the position.  a
+  /// game that ends before the last move isn't continued, so it isn't
+  /// counted.  the root moves are shared out between threads, and an
+  /// optional hash of subtree counts, shared by all of them, counts each
+  /// transposition once.  the count is exact with or without the hash.
+  /// </summary>
+  /// <param name="Position">the position to count from</param>
+  /// <param name="Depth">the number of moves in each sequence</param>
+  /// <param name="Threads">the number of threads to count on</param>
+  /// <param name="HashBytes">the size of the hash, or 0 for none; it needs PerftHashFits</param>
+  /// <returns>the counts</returns>
+  PerftResult Perft(const Board& Position, unsigned int Depth, unsigned int Threads, size_t HashBytes);
+}